@@ -0,0 +1,140 @@
+/*
+ * Test Program for coroutine support in the Upwind Threading Library
+ * Tests uthread_coro.hpp: co_spawn, sleep, co_mutex, fd_readable,
+ * and restarting the executor once it has gone idle
+ *
+ * Build: gcc -c uthread.c scheduler.c &&
+ *        g++ -std=c++20 -I. coro_demo.cpp uthread.o scheduler.o -o coro_demo
+ */
+
+#include "uthread_coro.hpp"
+#include <cstdio>
+#include <unistd.h>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  - %s: %s\n", what, ok ? "OK" : "FAILED");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// Spins until `count` reaches `target`; preemption lets the executor run
+static void wait_for(const int& count, int target) {
+    for (;;) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        if (count >= target) {
+            return;
+        }
+    }
+}
+
+static void busy_work(int iterations) {
+    for (volatile int i = 0; i < iterations;) {
+        i = i + 1;
+    }
+}
+
+static uthread::co_mutex mutex;
+static int in_critical = 0;
+static int max_in_critical = 0;
+static int lock_order[3];
+static int locked_count = 0;
+static int workers_done = 0;
+
+uthread::task worker(int id, int delay) {
+    co_await uthread::sleep(delay);
+
+    co_await mutex;
+    in_critical++;
+    if (in_critical > max_in_critical) {
+        max_in_critical = in_critical;
+    }
+    lock_order[locked_count++] = id;
+    printf("[CORO %d] holding mutex\n", id);
+    co_await uthread::sleep(2);  // keep it held so the others queue up
+    in_critical--;
+    mutex.unlock();
+
+    workers_done++;
+}
+
+static unsigned long slept_from = 0;
+static unsigned long slept_until = 0;
+static int sleeper_done = 0;
+
+uthread::task sleeper(int quantums) {
+    slept_from = get_quantum_count();
+    co_await uthread::sleep(quantums);
+    slept_until = get_quantum_count();
+    sleeper_done++;
+}
+
+static char read_char = 0;
+static int reader_done = 0;
+
+uthread::task reader(int fd) {
+    co_await uthread::fd_readable{fd};
+    if (read(fd, &read_char, 1) != 1) {
+        read_char = '?';
+    }
+    reader_done++;
+}
+
+int main() {
+    printf("Upwind Threading Library Coroutine Test\n\n");
+
+    if (uthread_system_init(100000) < 0) {
+        fprintf(stderr, "FAILED: uthread_system_init\n");
+        return 1;
+    }
+
+    // TEST: sleep
+    printf("[MAIN] Testing co_await uthread::sleep(3)\n");
+    check(uthread::co_spawn(sleeper(3)) == 0, "co_spawn() succeeded");
+    wait_for(sleeper_done, 1);
+    check(slept_until - slept_from >= 3, "slept for at least 3 quantums");
+
+    // TEST: co_mutex under contention
+    printf("\n[MAIN] Testing co_mutex with 3 contending coroutines\n");
+    for (int id = 1; id <= 3; id++) {
+        uthread::co_spawn(worker(id, 0));
+    }
+    wait_for(workers_done, 3);
+    check(max_in_critical == 1, "at most one coroutine held the mutex");
+    check(lock_order[0] == 1 && lock_order[1] == 2 && lock_order[2] == 3,
+          "waiters acquired in FIFO order");
+    check(mutex.try_lock(), "mutex free after the last unlock()");
+    mutex.unlock();
+
+    // TEST: fd_readable
+    printf("\n[MAIN] Testing co_await uthread::fd_readable\n");
+    int fds[2];
+    if (pipe(fds) < 0) {
+        perror("pipe failed");
+        return 1;
+    }
+    uthread::co_spawn(reader(fds[0]));
+    busy_work(50000000);
+    check(reader_done == 0, "reader still waiting on empty pipe");
+    if (write(fds[1], "x", 1) != 1) {
+        perror("write failed");
+        return 1;
+    }
+    wait_for(reader_done, 1);
+    check(read_char == 'x', "reader resumed and read the byte");
+    close(fds[0]);
+    close(fds[1]);
+
+    // TEST: executor exits when idle and is restarted by the next co_spawn()
+    printf("\n[MAIN] Testing executor restart\n");
+    busy_work(50000000);
+    check(uthread::detail::executor.tid == -1, "executor exited once idle");
+    check(uthread::co_spawn(sleeper(1)) == 0, "co_spawn() restarted the executor");
+    wait_for(sleeper_done, 2);
+    check(sleeper_done == 2, "task on the restarted executor ran");
+
+    printf("\n=== Coroutine Test Results: %s ===\n", failures == 0 ? "PASSED" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+/*
+ * Test Program for the C++ layer of the Upwind Threading Library
+ * Tests uthread.hpp: spawn, handle move, join, TID reuse after exit
+ *
+ * Build: gcc -c uthread.c scheduler.c &&
+ *        g++ -std=c++17 -I. cpp_demo.cpp uthread.o scheduler.o -o cpp_demo
+ */
+
+#include "uthread.hpp"
+#include <cstdio>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  - %s: %s\n", what, ok ? "OK" : "FAILED");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// Counts live copies so we can see the closure slot destroying its callable
+struct tracked {
+    static int live;
+    int* out;
+    int value;
+
+    tracked(int* o, int v) : out(o), value(v) { live++; }
+    tracked(tracked&& other) noexcept : out(other.out), value(other.value) { live++; }
+    ~tracked() { live--; }
+
+    void operator()() {
+        *out = value;
+        for (volatile int j = 0; j < 20000000; j = j + 1);
+    }
+};
+int tracked::live = 0;
+
+int main() {
+    printf("Upwind Threading Library C++ Test\n\n");
+
+    if (uthread_system_init(100000) < 0) {
+        fprintf(stderr, "FAILED: uthread_system_init\n");
+        return 1;
+    }
+
+    // TEST: spawn with captured state, join
+    printf("[MAIN] Testing uthread::spawn() with captured state\n");
+    int sum = 0;
+    int step = 7;
+    {
+        uthread::thread t = uthread::spawn([&sum, step] {
+            for (int i = 0; i < 3; i++) {
+                sum += step;
+                for (volatile int j = 0; j < 20000000; j = j + 1);
+            }
+        });
+        check(t.joinable(), "spawn returned a joinable handle");
+        check(t.join() == 0, "join() succeeded");
+        check(!t.joinable(), "handle empty after join");
+    }
+    check(sum == 21, "captured state updated (sum == 21)");
+
+    // TEST: moving a handle, join on destruction
+    printf("\n[MAIN] Testing handle move and join on destruction\n");
+    int moved_result = 0;
+    {
+        uthread::thread a = uthread::spawn([&moved_result] { moved_result = 42; });
+        int tid = a.get_id();
+        uthread::thread b = std::move(a);
+        check(!a.joinable(), "moved-from handle is empty");
+        check(b.get_id() == tid, "moved-to handle owns the TID");
+    }
+    check(moved_result == 42, "destructor joined the thread");
+
+    // TEST: the callable is destroyed when the thread finishes
+    printf("\n[MAIN] Testing closure slot cleanup\n");
+    int out = 0;
+    {
+        uthread::thread t = uthread::spawn(tracked(&out, 5));
+        check(tracked::live == 1, "callable lives in the slot while running");
+    }
+    check(out == 5 && tracked::live == 0, "callable ran and was destroyed");
+
+    // TEST: TID reuse after uthread_exit() of a spawned thread
+    printf("\n[MAIN] Testing TID reuse after uthread_exit()\n");
+    int never = 0;
+    uthread::thread victim = uthread::spawn(tracked(&never, 1));
+    int victim_tid = victim.get_id();
+    check(uthread_exit(victim_tid) == 0, "uthread_exit() on spawned thread");
+    check(victim.finished(), "handle reports the terminated thread as finished");
+    victim.join();
+
+    int reused = 0;
+    uthread::thread next = uthread::spawn([&reused] { reused = 1; });
+    check(next.get_id() == victim_tid, "new spawn reuses the freed TID");
+    check(tracked::live == 0, "stale callable of the terminated thread destroyed");
+    next.join();
+    check(reused == 1, "thread on the reused TID ran");
+
+    // TEST: error cases
+    printf("\n[MAIN] Testing invalid operations (should fail):\n");
+    uthread::thread empty;
+    check(empty.join() == -1, "join() on an empty handle");
+    check(uthread::this_thread::sleep_for(1) == -1, "sleep_for() from main thread");
+
+    printf("\n=== C++ Layer Test Results: %s ===\n", failures == 0 ? "PASSED" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -11,6 +11,9 @@
 static int ready_queue[QUEUE_SIZE];
 static int front = 0, rear = 0, size = 0;
 
+// Number of scheduling rounds so far (the clock sleep_table counts in)
+static unsigned long quantum_count = 0;
+
 // For launching new threads
 static int new_thread_launch = 0;
 static int new_thread_id = -1;
@@ -77,6 +80,10 @@ int remove_tid_from_ready_queue(int tid) {
     return 0;
 }
 
+unsigned long get_quantum_count(void) {
+    return quantum_count;
+}
+
 // Scheduler 
 void schedule(int sig) {
     (void)sig;
@@ -116,6 +123,7 @@ void schedule(int sig) {
     }
 
     // Wake up sleeping threads
+    quantum_count++;
     for (int i = 0; i < UTHREAD_MAX_THREADS; i++) {
         if (threads[i].tid != -1 && sleep_table[i] > 0 && threads[i].state == BLOCKED) {
             sleep_table[i]--;
@@ -3,9 +3,18 @@
 
 #include "uthread.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void schedule(int sig);
 void enqueue_ready(int tid);
 int dequeue_ready(void);
 int remove_tid_from_ready_queue(int tid);
+unsigned long get_quantum_count(void);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif 
\ No newline at end of file
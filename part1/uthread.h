@@ -15,6 +15,10 @@
 #define UTHREAD_MAX_THREADS 10    /* Maximum number of concurrent threads */
 #define UTHREAD_STACK_BYTES 4096  /* Stack size per thread in bytes */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef void (*uthread_entry)(void);
 
 /* ===========================
@@ -121,4 +125,8 @@ sigset_t* get_uthread_sigset(void);
 int* get_sleep_table(void);
 void thread_func_wrapper(void);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* UTHREAD_H */
\ No newline at end of file
@@ -0,0 +1,241 @@
+/*
+ * User-Level Threading Library (Upwind Threads)
+ * Header-only C++ layer
+ *
+ * Wraps the C API in uthread.h so that C++ code can start a thread from any
+ * callable (lambda, functor, ...) instead of a bare `void(*)(void)`.
+ *
+ * The callable is stored in a fixed per-TID slot with an inline buffer, so
+ * spawning never touches the heap: the cost is one move-construction plus
+ * the regular uthread_create() call.
+ *
+ *     auto t = uthread::spawn([&counter, step] { counter += step; });
+ *     ...
+ *     // t joins on destruction (or call t.join() / t.detach() explicitly)
+ */
+#ifndef UTHREAD_HPP
+#define UTHREAD_HPP
+
+#include "uthread.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace uthread {
+
+/* Largest callable (captured state) that fits in a thread's closure slot. */
+inline constexpr std::size_t closure_bytes = 64;
+
+namespace detail {
+
+struct closure_slot {
+    alignas(std::max_align_t) unsigned char storage[closure_bytes];
+    void (*invoke)(void*) = nullptr;
+    void (*destroy)(void*) = nullptr;
+    unsigned generation = 0;  // bumped every time the slot's callable is released
+};
+
+inline closure_slot slots[UTHREAD_MAX_THREADS];
+
+// Blocks SIGVTALRM for the lifetime of the guard (same as uthread_create does)
+class preempt_guard {
+public:
+    preempt_guard() {
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, SIGVTALRM);
+        sigprocmask(SIG_BLOCK, &set, &old_);
+    }
+    ~preempt_guard() { sigprocmask(SIG_SETMASK, &old_, nullptr); }
+
+    preempt_guard(const preempt_guard&) = delete;
+    preempt_guard& operator=(const preempt_guard&) = delete;
+
+private:
+    sigset_t old_;
+};
+
+// Destroys the callable held by a slot, if any. Caller must block preemption.
+inline void release(closure_slot& s) {
+    if (s.destroy) {
+        s.destroy(s.storage);
+    }
+    s.invoke = nullptr;
+    s.destroy = nullptr;
+    ++s.generation;
+}
+
+// Entry point handed to uthread_create(); runs the callable of the current TID.
+// A thread restarted by block/sleep re-enters here and re-runs the same callable,
+// matching the behaviour of plain C entry functions.
+inline void trampoline() {
+    closure_slot& s = slots[get_current_tid()];
+    if (s.invoke) {
+        s.invoke(s.storage);
+    }
+
+    preempt_guard guard;
+    release(s);
+}
+
+// Mirrors the TID selection in uthread_create(): lowest free TID above 0.
+inline int next_free_tid() {
+    Thread* threads = get_threads();
+    for (int i = 1; i < UTHREAD_MAX_THREADS; ++i) {
+        if (threads[i].tid == -1) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Owning handle to a thread started with uthread::spawn().
+ *
+ * Move-only. If the handle is still joinable when destroyed, the destructor
+ * waits for the thread to finish (see join() for when that never happens).
+ */
+class thread {
+public:
+    thread() = default;
+
+    thread(thread&& other) noexcept
+        : tid_(std::exchange(other.tid_, -1)), generation_(other.generation_) {}
+
+    thread& operator=(thread&& other) noexcept {
+        if (this != &other) {
+            join();
+            tid_ = std::exchange(other.tid_, -1);
+            generation_ = other.generation_;
+        }
+        return *this;
+    }
+
+    thread(const thread&) = delete;
+    thread& operator=(const thread&) = delete;
+
+    ~thread() { join(); }
+
+    /** @return The thread's TID, or -1 for an empty handle. */
+    int get_id() const { return tid_; }
+
+    bool joinable() const { return tid_ != -1; }
+
+    explicit operator bool() const { return joinable(); }
+
+    /** @return true once the callable has returned or the thread was terminated. */
+    bool finished() const {
+        if (tid_ == -1) {
+            return true;
+        }
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        const Thread& t = get_threads()[tid_];
+        return t.tid == -1 || t.entry != &detail::trampoline ||
+               detail::slots[tid_].generation != generation_;
+    }
+
+    /**
+     * @brief Waits for the thread to finish.
+     *
+     * Busy-waits until preemption lets the target run to completion, since
+     * a blocked or sleeping caller would restart from its entry function.
+     * If the target has blocked itself with uthread_block() and nobody calls
+     * uthread_unblock(), this spins forever - and so does ~thread().
+     *
+     * @return 0 on success, -1 on failure (empty handle or joining itself).
+     */
+    int join() {
+        if (tid_ == -1 || tid_ == get_current_tid()) {
+            return -1;
+        }
+        while (!finished()) {
+        }
+        tid_ = -1;
+        return 0;
+    }
+
+    /** @brief Releases ownership; the thread keeps running unjoined. */
+    void detach() { tid_ = -1; }
+
+private:
+    template <class F>
+    friend thread spawn(F&& f);
+
+    thread(int tid, unsigned generation) : tid_(tid), generation_(generation) {}
+
+    int tid_ = -1;
+    unsigned generation_ = 0;
+};
+
+/**
+ * @brief Creates a new thread running the given callable.
+ *
+ * The callable is moved into the new thread's closure slot; no heap
+ * allocation takes place. Its size must not exceed `uthread::closure_bytes`.
+ *
+ * @return A joinable handle on success, an empty handle on failure
+ *         (system not initialized or too many threads).
+ */
+template <class F>
+thread spawn(F&& f) {
+    using Fn = std::decay_t<F>;
+    static_assert(std::is_invocable_v<Fn&>, "uthread::spawn: callable must take no arguments");
+    static_assert(sizeof(Fn) <= closure_bytes, "uthread::spawn: captured state exceeds closure_bytes");
+    static_assert(alignof(Fn) <= alignof(std::max_align_t), "uthread::spawn: over-aligned callable");
+
+    detail::preempt_guard guard;
+
+    int tid = detail::next_free_tid();
+    if (tid == -1) {
+        std::fprintf(stderr, "uthread::spawn: system not initialized or too many threads\n");
+        return thread();
+    }
+
+    // A slot can still hold the callable of a thread terminated by uthread_exit()
+    detail::closure_slot& s = detail::slots[tid];
+    detail::release(s);
+
+    ::new (static_cast<void*>(s.storage)) Fn(std::forward<F>(f));
+    s.invoke = [](void* p) { (*static_cast<Fn*>(p))(); };
+    s.destroy = [](void* p) { static_cast<Fn*>(p)->~Fn(); };
+    unsigned generation = s.generation;
+
+    if (uthread_create(&detail::trampoline) != tid) {
+        detail::release(s);
+        return thread();
+    }
+
+    return thread(tid, generation);
+}
+
+namespace this_thread {
+
+/** @return TID of the calling thread. */
+inline int get_id() { return get_current_tid(); }
+
+/**
+ * @brief Puts the calling thread to sleep; see uthread_sleep_quantums().
+ *
+ * Unlike std::this_thread::sleep_for, this does NOT return to the caller on
+ * success: the library wakes a sleeping thread by restarting it from its
+ * entry function, so the spawned callable runs again from the top and code
+ * after the call never executes. Only use it as the last statement of a
+ * callable whose state makes re-running it meaningful.
+ *
+ * @param num_quantums The number of quantums to sleep.
+ * @return -1 on failure (invalid parameters or called from the main thread);
+ *         does not return on success.
+ */
+inline int sleep_for(int num_quantums) { return uthread_sleep_quantums(num_quantums); }
+
+}  // namespace this_thread
+
+}  // namespace uthread
+
+#endif /* UTHREAD_HPP */
@@ -0,0 +1,392 @@
+/*
+ * User-Level Threading Library (Upwind Threads)
+ * C++20 coroutine support
+ *
+ * Lets stackless coroutines run on the uthread scheduler. All coroutines are
+ * resumed by a single executor uthread, which is started on demand and woken
+ * through the regular READY queue (uthread_unblock / sleep_table), so
+ * coroutines and uthreads share one run loop and one SIGVTALRM timer.
+ *
+ *     uthread::co_mutex m;
+ *
+ *     uthread::task worker(int fd) {
+ *         co_await uthread::sleep(2);            // 2 quantums
+ *         co_await uthread::fd_readable{fd};     // until poll() says POLLIN
+ *         co_await m;                            // acquire
+ *         ...
+ *         m.unlock();
+ *     }
+ *
+ *     uthread::co_spawn(worker(fd));
+ *
+ * Waiting state lives in the coroutine frame; the executor only links it into
+ * intrusive lists, so awaiting never allocates. Coroutine bodies must not call
+ * uthread_block() / uthread_sleep_quantums() themselves: those restart the
+ * executor and the suspended-in-flight coroutine would never be resumed.
+ */
+#ifndef UTHREAD_CORO_HPP
+#define UTHREAD_CORO_HPP
+
+#include "uthread.hpp"
+#include "scheduler.h"
+
+#include <coroutine>
+#include <cstdio>
+#include <exception>
+#include <utility>
+#include <poll.h>
+
+namespace uthread {
+
+namespace detail {
+
+struct co_node {
+    std::coroutine_handle<> handle;
+    co_node* next = nullptr;
+};
+
+struct co_timer_node : co_node {
+    unsigned long deadline = 0;
+};
+
+struct co_fd_node : co_node {
+    int fd = -1;
+};
+
+struct co_executor {
+    co_node* ready_head = nullptr;
+    co_node* ready_tail = nullptr;
+    co_node* timers = nullptr;  // co_timer_node entries
+    co_node* fds = nullptr;     // co_fd_node entries
+    int tid = -1;
+};
+
+inline co_executor executor;
+
+inline void co_run_loop();
+
+// Caller must block preemption
+inline void co_push_ready(co_node* n) {
+    n->next = nullptr;
+    if (executor.ready_tail) {
+        executor.ready_tail->next = n;
+    } else {
+        executor.ready_head = n;
+    }
+    executor.ready_tail = n;
+}
+
+// Caller must block preemption
+inline co_node* co_pop_ready() {
+    co_node* n = executor.ready_head;
+    if (n) {
+        executor.ready_head = n->next;
+        if (!executor.ready_head) {
+            executor.ready_tail = nullptr;
+        }
+    }
+    return n;
+}
+
+// Makes sure the executor uthread will run: starts it if needed, or wakes it
+// early from its sleep. Caller must block preemption.
+inline int co_wake_executor() {
+    if (executor.tid == -1) {
+        executor.tid = uthread_create(&co_run_loop);
+        if (executor.tid == -1) {
+            std::fprintf(stderr, "uthread::co_wake_executor: cannot start executor thread\n");
+            return -1;
+        }
+        return 0;
+    }
+
+    if (get_threads()[executor.tid].state == BLOCKED) {
+        return uthread_unblock(executor.tid);
+    }
+    return 0;
+}
+
+// Queues a suspended coroutine for resumption on the executor
+inline int co_post(co_node* n) {
+    preempt_guard guard;
+    co_push_ready(n);
+    return co_wake_executor();
+}
+
+// Moves expired timers and readable fds to the ready list. Caller must block preemption.
+inline void co_collect() {
+    unsigned long now = get_quantum_count();
+    for (co_node** p = &executor.timers; *p;) {
+        co_node* t = *p;
+        if (static_cast<long>(now - static_cast<co_timer_node*>(t)->deadline) >= 0) {
+            *p = t->next;
+            co_push_ready(t);
+        } else {
+            p = &t->next;
+        }
+    }
+
+    for (co_node** p = &executor.fds; *p;) {
+        co_node* f = *p;
+        struct pollfd pfd = {static_cast<co_fd_node*>(f)->fd, POLLIN, 0};
+        if (poll(&pfd, 1, 0) != 0) {  // readable, hung up, or error: let the coroutine find out
+            *p = f->next;
+            co_push_ready(f);
+        } else {
+            p = &f->next;
+        }
+    }
+}
+
+// Entry function of the executor uthread. Since sleeping restarts a uthread
+// from its entry, all loop state lives in `executor`, not on the stack.
+inline void co_run_loop() {
+    for (;;) {
+        co_node* n;
+        {
+            preempt_guard guard;
+            n = co_pop_ready();
+            if (!n) {
+                co_collect();
+                n = co_pop_ready();
+            }
+        }
+
+        if (n) {
+            n->handle.resume();
+            continue;
+        }
+
+        // Nothing runnable. Preemption stays blocked until we are off the CPU
+        // so a co_post() cannot slip in between the check and the sleep.
+        preempt_guard guard;
+        if (executor.ready_head) {
+            continue;
+        }
+
+        if (!executor.timers && !executor.fds) {
+            executor.tid = -1;  // next co_post() starts a fresh executor
+            return;
+        }
+
+        int quantums = 1;
+        if (!executor.fds) {
+            unsigned long now = get_quantum_count();
+            long nearest = static_cast<long>(
+                static_cast<co_timer_node*>(executor.timers)->deadline - now);
+            for (co_node* t = executor.timers; t; t = t->next) {
+                long left = static_cast<long>(static_cast<co_timer_node*>(t)->deadline - now);
+                if (left < nearest) {
+                    nearest = left;
+                }
+            }
+            if (nearest > 1) {
+                quantums = static_cast<int>(nearest);
+            }
+        }
+        uthread_sleep_quantums(quantums);  // restarts co_run_loop() on wake-up
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Fire-and-forget coroutine type; start it with uthread::co_spawn().
+ *
+ * The frame is destroyed when the coroutine finishes. A task that is never
+ * spawned is destroyed together with its handle.
+ */
+class task {
+public:
+    struct promise_type {
+        detail::co_node node;
+
+        task get_return_object() {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    task(task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    ~task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+private:
+    friend int co_spawn(task t);
+
+    explicit task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief Schedules a task to start running on the executor uthread.
+ *
+ * @return 0 on success, -1 on failure (executor thread could not be created;
+ *         the task stays queued and starts with the next successful spawn).
+ */
+inline int co_spawn(task t) {
+    auto h = std::exchange(t.handle_, nullptr);
+    detail::co_node* n = &h.promise().node;
+    n->handle = h;
+    return detail::co_post(n);
+}
+
+/** Awaitable returned by uthread::sleep(). */
+class sleep_awaiter {
+public:
+    explicit sleep_awaiter(int num_quantums) : quantums_(num_quantums) {}
+
+    bool await_ready() const noexcept { return quantums_ <= 0; }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        detail::preempt_guard guard;
+        node_.handle = h;
+        node_.deadline = get_quantum_count() + static_cast<unsigned long>(quantums_);
+        node_.next = detail::executor.timers;
+        detail::executor.timers = &node_;
+        detail::co_wake_executor();
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    int quantums_;
+    detail::co_timer_node node_;
+};
+
+/**
+ * @brief Suspends the calling coroutine for a number of quantums.
+ *
+ * Uses the same clock as uthread_sleep_quantums().
+ */
+inline sleep_awaiter sleep(int num_quantums) { return sleep_awaiter(num_quantums); }
+
+/**
+ * @brief Awaitable that resumes once `fd` is readable (or hung up / in error).
+ *
+ * The executor polls waiting descriptors once per scheduling round.
+ */
+class fd_readable {
+public:
+    explicit fd_readable(int fd) { node_.fd = fd; }
+
+    bool await_ready() const noexcept {
+        struct pollfd pfd = {node_.fd, POLLIN, 0};
+        return poll(&pfd, 1, 0) != 0;
+    }
+
+    void await_suspend(std::coroutine_handle<> h) {
+        detail::preempt_guard guard;
+        node_.handle = h;
+        node_.next = detail::executor.fds;
+        detail::executor.fds = &node_;
+        detail::co_wake_executor();
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    detail::co_fd_node node_;
+};
+
+/**
+ * @brief Mutex for coroutines: `co_await m` acquires it, `m.unlock()` releases.
+ *
+ * Ownership is handed directly to the oldest waiter, which is then resumed
+ * through the executor's ready list. unlock() may also be called from a
+ * plain uthread.
+ */
+class co_mutex {
+public:
+    class lock_awaiter {
+    public:
+        explicit lock_awaiter(co_mutex& m) : mutex_(m) {}
+
+        bool await_ready() noexcept { return mutex_.try_lock(); }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            detail::preempt_guard guard;
+            if (!mutex_.locked_) {  // released since await_ready()
+                mutex_.locked_ = true;
+                return false;
+            }
+            node_.handle = h;
+            node_.next = nullptr;
+            if (mutex_.tail_) {
+                mutex_.tail_->next = &node_;
+            } else {
+                mutex_.head_ = &node_;
+            }
+            mutex_.tail_ = &node_;
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        co_mutex& mutex_;
+        detail::co_node node_;
+    };
+
+    co_mutex() = default;
+    co_mutex(const co_mutex&) = delete;
+    co_mutex& operator=(const co_mutex&) = delete;
+
+    lock_awaiter operator co_await() { return lock_awaiter(*this); }
+
+    /** @return true if the mutex was free and is now held by the caller. */
+    bool try_lock() {
+        detail::preempt_guard guard;
+        if (locked_) {
+            return false;
+        }
+        locked_ = true;
+        return true;
+    }
+
+    void unlock() {
+        detail::preempt_guard guard;
+        detail::co_node* n = head_;
+        if (!n) {
+            locked_ = false;
+            return;
+        }
+
+        // Stays locked: ownership passes to the waiter
+        head_ = n->next;
+        if (!head_) {
+            tail_ = nullptr;
+        }
+        detail::co_push_ready(n);
+        detail::co_wake_executor();
+    }
+
+private:
+    bool locked_ = false;
+    detail::co_node* head_ = nullptr;
+    detail::co_node* tail_ = nullptr;
+};
+
+}  // namespace uthread
+
+#endif /* UTHREAD_CORO_HPP */
@@ -1,72 +1,218 @@
 import os
+import time
+import heapq
+import itertools
+import random
+import argparse
+import threading
 from glob import glob
 from collections import defaultdict, Counter
-from llms.openai_classifier import OpenAIClassifier
-from llms.bedrock_classifier import BedrockClassifier
-# from llms.ollama_classifier import OllamaClassifier
+from concurrent.futures import Future, ThreadPoolExecutor
 from utils import read_JSON_file
+from llms.result_cache import ResultCache
 
-def main():
-    print("Scanning for policy files...")
-    weak_policy_paths = glob("part2/policies/weak/*.json")
-    strong_policy_paths = glob("part2/policies/strong/*.json")
-    all_policy_paths = weak_policy_paths + strong_policy_paths
+def load_models(model_names):
+    """
+    Instantiates the requested classifiers.
 
-    if not all_policy_paths:
-        print("Error: No policy files found in 'part2/policies/weak/' or 'part2/policies/strong/'.")
-        return
+    Imports are done per model so that an offline run (e.g. Ollama only)
+    does not need the SDKs of the remote providers.
+    """
+    models = {}
+    for model_name in model_names:
+        if model_name == "OpenAI":
+            from llms.openai_classifier import OpenAIClassifier
+            models[model_name] = OpenAIClassifier()
+        elif model_name == "Bedrock":
+            from llms.bedrock_classifier import BedrockClassifier
+            models[model_name] = BedrockClassifier()
+        elif model_name == "Ollama":
+            from llms.ollama_classifier import OllamaClassifier
+            models[model_name] = OllamaClassifier()
+        else:
+            raise ValueError(f"Unknown model: {model_name}")
+    return models
 
-    print(f"Found {len(weak_policy_paths)} weak and {len(strong_policy_paths)} strong policies.")
-    print("Initializing models...")
+def backoff_delay(backoff, attempt):
+    """Exponential backoff with jitter for the given (0-based) attempt."""
+    return backoff * (2 ** attempt) * random.uniform(0.5, 1.5)
+
+def classify_attempt(model, policy_json, attempt):
+    """
+    Runs one classification attempt. Only the first attempt consults the
+    cache; retries go straight to the model so each policy is looked up once.
+    """
+    if attempt == 0:
+        return model.classify_policy(policy_json)
+    return model.classify_and_store(policy_json)
+
+def classify_with_retry(model, policy_json, retries, backoff):
+    """
+    Classifies a policy, retrying with exponential backoff and jitter
+    when the model raises or returns no result.
+    """
+    for attempt in range(retries + 1):
+        try:
+            result = classify_attempt(model, policy_json, attempt)
+            if result or attempt == retries:
+                return result
+        except Exception:
+            if attempt == retries:
+                raise
+        time.sleep(backoff_delay(backoff, attempt))
+
+class RetryScheduler:
+    """
+    Runs delayed callbacks from a single thread, ordered by due time.
+
+    Waiting retries are only heap entries, so the number of threads stays
+    fixed no matter how many requests are backing off.
+    """
 
-    models = {
-        "OpenAI": OpenAIClassifier(),
-        "Bedrock": BedrockClassifier(),
-        # "Ollama": OllamaClassifier(),
+    def __init__(self):
+        self._heap = []
+        self._seq = itertools.count()  # tie-breaker so callbacks are never compared
+        self._cond = threading.Condition()
+        self._closed = False
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def call_later(self, delay, fn, *args):
+        with self._cond:
+            heapq.heappush(self._heap, (time.monotonic() + delay, next(self._seq), fn, args))
+            self._cond.notify()
+
+    def shutdown(self):
+        """Stops the thread; callbacks that are not yet due are dropped."""
+        with self._cond:
+            self._closed = True
+            self._cond.notify()
+        self._thread.join()
+
+    def _run(self):
+        while True:
+            with self._cond:
+                while not self._closed:
+                    if self._heap:
+                        delay = self._heap[0][0] - time.monotonic()
+                        if delay <= 0:
+                            break
+                        self._cond.wait(delay)
+                    else:
+                        self._cond.wait()
+                if self._closed:
+                    return
+                _, _, fn, args = heapq.heappop(self._heap)
+            fn(*args)
+
+def submit_with_retry(pool, scheduler, fn, retries, backoff):
+    """
+    Submits fn(attempt) to pool and returns a Future for its final outcome.
+
+    A failed or empty attempt is resubmitted by the scheduler after the
+    backoff delay, so no pool worker sits sleeping between attempts.
+    """
+    outcome = Future()
+
+    def attempt(n):
+        pool.submit(fn, n).add_done_callback(lambda f: on_done(f, n))
+
+    def on_done(f, n):
+        error = f.exception()
+        result = None if error else f.result()
+        if (error or not result) and n < retries:
+            scheduler.call_later(backoff_delay(backoff, n), attempt, n + 1)
+        elif error:
+            outcome.set_exception(error)
+        else:
+            outcome.set_result(result)
+
+    attempt(0)
+    return outcome
+
+def make_result(model_name, policy_name, label, result=None, error=None):
+    """
+    Builds the result record for one policy/model pair and reports it.
+    """
+    model_result = {
+        "model": model_name,
+        "policy": policy_name,
+        "expected": label,
+        "classification": None,
+        "match": None,
+        "reason": None
     }
 
-    results = []
+    if error:
+        model_result["classification"] = "Error"
+        model_result["reason"] = str(error)
+        print(f"[{policy_name}] {model_name}: Error during classification: {error}")
+    elif result:
+        classification = result.get("classification")
+        match = classification == label
+
+        model_result["classification"] = classification
+        model_result["match"] = match
+        model_result["reason"] = result.get("reason")
+
+        print(f"[{policy_name}] {model_name}: Classified as: {classification} | Match: {match}")
+    else:
+        print(f"[{policy_name}] {model_name}: Warning: Model returned no result.")
+
+    return model_result
 
-    for policy_path in all_policy_paths:
-        label = "Weak" if "weak" in policy_path else "Strong"
-        policy_json = read_JSON_file(policy_path)
-        policy_name = os.path.basename(policy_path)
+def load_policy(policy_path):
+    label = "Weak" if "weak" in policy_path else "Strong"
+    return os.path.basename(policy_path), label, read_JSON_file(policy_path)
 
+def run_sequential(models, policy_paths, retries, backoff):
+    results = []
+    for policy_path in policy_paths:
+        policy_name, label, policy_json = load_policy(policy_path)
         print(f"\nProcessing policy: {policy_name} (expected: {label})")
 
         for model_name, model in models.items():
-            print(f"  Model: {model_name}")
+            try:
+                result = classify_with_retry(model, policy_json, retries, backoff)
+                results.append(make_result(model_name, policy_name, label, result=result))
+            except Exception as e:
+                results.append(make_result(model_name, policy_name, label, error=e))
+    return results
+
+def run_concurrent(models, policy_paths, limits, retries, backoff):
+    """
+    Fans out every (policy, model) pair concurrently.
+    Each model gets its own pool sized to limits[model_name], so a slow
+    provider only ever occupies its own workers and never delays the others.
+    """
+    pools = {model_name: ThreadPoolExecutor(max_workers=limits[model_name]) for model_name in models}
+    scheduler = RetryScheduler()
 
-            model_result = {
-                "model": model_name,
-                "policy": policy_name,
-                "expected": label,
-                "classification": None,
-                "match": None,
-                "reason": None
-            }
+    try:
+        pending = []
+        for policy_path in policy_paths:
+            policy_name, label, policy_json = load_policy(policy_path)
+            for model_name, model in models.items():
+                outcome = submit_with_retry(pools[model_name], scheduler,
+                                            lambda n, m=model, p=policy_json: classify_attempt(m, p, n),
+                                            retries, backoff)
+                pending.append((model_name, policy_name, label, outcome))
 
+        # Collected in submission order so the summary matches sequential mode
+        results = []
+        for model_name, policy_name, label, outcome in pending:
             try:
-                result = model.classify_policy(policy_json)
-                if result:
-                    classification = result.get("classification")
-                    match = classification == label
-
-                    model_result["classification"] = classification
-                    model_result["match"] = match
-                    model_result["reason"] = result.get("reason")
-
-                    print(f"Classified as: {classification} | Match: {match}")
-                else:
-                    print("Warning: Model returned no result.")
+                results.append(make_result(model_name, policy_name, label, result=outcome.result()))
             except Exception as e:
-                model_result["classification"] = "Error"
-                model_result["reason"] = str(e)
-                print(f"Error during classification: {e}")
+                results.append(make_result(model_name, policy_name, label, error=e))
+        return results
+    finally:
+        # On the normal path every outcome is resolved, so nothing is left to resubmit
+        scheduler.shutdown()
+        for pool in pools.values():
+            pool.shutdown()
 
-            results.append(model_result)
-
-    # Summary
+def print_summary(results):
     summary = defaultdict(lambda: {"correct": 0, "wrong": 0, "reasons": []})
 
     for r in results:
@@ -96,5 +242,98 @@ def main():
         else:
             print("  No reasons provided for misclassifications.")
 
+def parse_limits(values, model_names, default=4):
+    """
+    Turns --max-per-model values into a {model: limit} dict.
+    A bare number sets the default; MODEL=N overrides a single model.
+    """
+    limits = {}
+    for value in values:
+        name, sep, count = value.rpartition("=")
+        try:
+            count = int(count)
+        except ValueError:
+            raise argparse.ArgumentTypeError(f"invalid --max-per-model value: {value}")
+        if count < 1:
+            raise argparse.ArgumentTypeError(f"--max-per-model must be at least 1: {value}")
+        if sep:
+            limits[name] = count
+        else:
+            default = count
+    return {model_name: limits.get(model_name, default) for model_name in model_names}
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Compare IAM policy classifications across models.")
+    parser.add_argument("--models", nargs="+", default=["OpenAI", "Bedrock"],
+                        choices=["OpenAI", "Bedrock", "Ollama"],
+                        help="Models to compare. Use 'Ollama' alone for an offline run "
+                             "(OLLAMA_HOST can point at a stub server).")
+    parser.add_argument("--concurrent", action="store_true",
+                        help="Classify policies concurrently instead of one request at a time.")
+    parser.add_argument("--max-per-model", nargs="+", default=[],
+                        help="Maximum in-flight requests per model in concurrent mode, e.g. "
+                             "'--max-per-model Ollama=1 OpenAI=8'. A bare number sets the default "
+                             "for models not listed (default: 4).")
+    parser.add_argument("--retries", type=int, default=None,
+                        help="Retries per request when a model fails or returns no result "
+                             "(default: 2 with --concurrent, 0 otherwise).")
+    parser.add_argument("--backoff", type=float, default=1.0,
+                        help="Base delay in seconds for exponential retry backoff.")
+    parser.add_argument("--cache-dir", default=None,
+                        help="Directory of the classification cache (default: $LLM_CACHE_DIR or part2/.cache).")
+    parser.add_argument("--no-cache", action="store_true",
+                        help="Always call the models; neither read nor write the cache.")
+    parser.add_argument("--clear-cache", action="store_true",
+                        help="Drop all cached results before running, e.g. after editing the prompt.")
+    args = parser.parse_args()
+
+    try:
+        args.limits = parse_limits(args.max_per_model, args.models)
+    except argparse.ArgumentTypeError as e:
+        parser.error(str(e))
+    return args
+
+def main():
+    args = parse_args()
+
+    print("Scanning for policy files...")
+    weak_policy_paths = glob("part2/policies/weak/*.json")
+    strong_policy_paths = glob("part2/policies/strong/*.json")
+    all_policy_paths = weak_policy_paths + strong_policy_paths
+
+    if not all_policy_paths:
+        print("Error: No policy files found in 'part2/policies/weak/' or 'part2/policies/strong/'.")
+        return
+
+    print(f"Found {len(weak_policy_paths)} weak and {len(strong_policy_paths)} strong policies.")
+    print("Initializing models...")
+
+    models = load_models(args.models)
+
+    cache = None
+    if not args.no_cache:
+        cache = ResultCache(args.cache_dir)
+        if args.clear_cache:
+            print(f"Clearing classification cache at {cache.cache_dir}")
+            cache.clear()
+        for model in models.values():
+            model.cache = cache
+
+    if args.concurrent:
+        retries = 2 if args.retries is None else args.retries
+        results = run_concurrent(models, all_policy_paths, args.limits, retries, args.backoff)
+    else:
+        retries = 0 if args.retries is None else args.retries
+        results = run_sequential(models, all_policy_paths, retries, args.backoff)
+
+    print_summary(results)
+
+    if cache:
+        stats = cache.stats()
+        print("\n=== Cache ===")
+        print(f"  Hits: {stats['hits']}")
+        print(f"  Misses: {stats['misses']}")
+        print(f"  Hit rate: {stats['hit_rate']:.2%}")
+
 if __name__ == "__main__":
     main()
@@ -4,6 +4,9 @@ import argparse
 from abc import ABC, abstractmethod
 from utils import read_JSON_file
 
+# Classifications the comparison summary accepts; only these are cached
+VALID_CLASSIFICATIONS = ("Weak", "Strong")
+
 class IAMClassifier(ABC):
     """
     Abstract base class for IAM policy classifiers.
@@ -11,6 +14,9 @@ class IAMClassifier(ABC):
     
     def __init__(self):
         self.client = None  # Subclasses must initialize this
+        self.model_id = None  # Subclasses must initialize this
+        self.system_instruction = ""  # Subclasses must initialize this
+        self.cache = None  # Optional ResultCache consulted by classify_policy
 
     @abstractmethod
     def test_connection(self) -> bool:
@@ -18,10 +24,42 @@ class IAMClassifier(ABC):
         pass
 
     @abstractmethod
-    def classify_policy(self, policy_json: dict) -> dict | None:
-        """Classifies the given IAM policy."""
+    def classify_policy_uncached(self, policy_json: dict) -> dict | None:
+        """Classifies the given IAM policy by calling the model."""
         pass
 
+    def cache_key(self, policy_json: dict) -> str:
+        return self.cache.make_key(f"{self.name()}:{self.model_id}", self.system_instruction, policy_json)
+
+    def cached_result(self, policy_json: dict) -> dict | None:
+        """
+        Returns the cached result for the given IAM policy, or None.
+        Each call counts as one lookup in the cache statistics.
+        """
+        if self.cache is None:
+            return None
+        return self.cache.get(self.cache_key(policy_json))
+
+    def classify_and_store(self, policy_json: dict) -> dict | None:
+        """
+        Calls the model and caches the result if it holds a usable
+        classification, so a malformed reply is never replayed.
+        """
+        result = self.classify_policy_uncached(policy_json)
+        if self.cache is not None and result and result.get("classification") in VALID_CLASSIFICATIONS:
+            self.cache.put(self.cache_key(policy_json), result)
+        return result
+
+    def classify_policy(self, policy_json: dict) -> dict | None:
+        """
+        Classifies the given IAM policy, answering from the cache when the
+        same model has already seen this policy with the same prompt.
+        """
+        result = self.cached_result(policy_json)
+        if result is not None:
+            return result
+        return self.classify_and_store(policy_json)
+
     def name(self) -> str:
         return self.__class__.__name__
 
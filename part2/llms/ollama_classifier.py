@@ -31,7 +31,7 @@ class OllamaClassifier(IAMClassifier):
             traceback.print_exc()
             return False
 
-    def classify_policy(self, policy_json: dict) -> dict | None:
+    def classify_policy_uncached(self, policy_json: dict) -> dict | None:
         try:
             user_prompt = f"Here is the IAM policy:\n{json.dumps(policy_json, indent=2)}\nReturn only the JSON output."
             messages = [
@@ -14,12 +14,13 @@ class OpenAIClassifier(IAMClassifier):
     def __init__(self):
         super().__init__()
         self.client = OpenAI(api_key=os.environ.get("OPENAI_API_KEY"))
+        self.model_id = "gpt-3.5-turbo"
         self.system_instruction = read_file(os.environ["LLM_INITIAL_PROMPT_PATH"])
 
     def test_connection(self) -> bool:
         try:
             response = self.client.chat.completions.create(
-                model="gpt-3.5-turbo",
+                model=self.model_id,
                 messages=[{"role": "user", "content": "Ping"}],
                 max_tokens=10
             )
@@ -31,11 +32,11 @@ class OpenAIClassifier(IAMClassifier):
             traceback.print_exc()
             return False
 
-    def classify_policy(self, policy_json: dict) -> dict | None:
+    def classify_policy_uncached(self, policy_json: dict) -> dict | None:
         user_prompt = f"Here is the IAM policy:\n{json.dumps(policy_json, indent=2)}\nReturn only the JSON output."
         try:
             response = self.client.chat.completions.create(
-                model="gpt-3.5-turbo",
+                model=self.model_id,
                 messages=[
                     {"role": "system", "content": self.system_instruction},
                     {"role": "user", "content": user_prompt}
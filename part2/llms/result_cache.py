@@ -0,0 +1,127 @@
+import os
+import json
+import re
+import hashlib
+import tempfile
+import threading
+
+# Layout written by put(): <2 hex chars>/<sha256>.json, via <sha256>.<random>.tmp
+SHARD_PATTERN = re.compile(r"^[0-9a-f]{2}$")
+ENTRY_PATTERN = re.compile(r"^[0-9a-f]{64}(\.json|\.[^/]*\.tmp)$")
+
+DEFAULT_CACHE_DIR = os.path.join(os.path.dirname(os.path.dirname(os.path.abspath(__file__))), ".cache", "classifications")
+
+class ResultCache:
+    """
+    Persistent, content-addressed cache of classification results.
+
+    Each result is stored as one JSON file named after the SHA-256 of
+    (model, prompt, canonicalized policy JSON), so a changed prompt or
+    policy simply misses. Safe to share between worker threads.
+    """
+
+    def __init__(self, cache_dir: str | None = None):
+        self.cache_dir = cache_dir or os.environ.get("LLM_CACHE_DIR", DEFAULT_CACHE_DIR)
+        self.hits = 0
+        self.misses = 0
+        self._lock = threading.Lock()
+
+    @staticmethod
+    def make_key(model: str, prompt: str, policy_json) -> str:
+        canonical = json.dumps(
+            {"model": model, "prompt": prompt, "policy": policy_json},
+            sort_keys=True, separators=(",", ":"), ensure_ascii=False
+        )
+        return hashlib.sha256(canonical.encode("utf-8")).hexdigest()
+
+    def _path(self, key: str) -> str:
+        return os.path.join(self.cache_dir, key[:2], f"{key}.json")
+
+    def get(self, key: str) -> dict | None:
+        """
+        Returns the cached result, or None. Unreadable or corrupt entries
+        count as a miss rather than failing the classification.
+        """
+        try:
+            with open(self._path(key), "r", encoding="utf-8") as f:
+                result = json.load(f)
+        except FileNotFoundError:
+            result = None
+        except (OSError, ValueError) as e:  # ValueError covers JSON and Unicode decode errors
+            print(f"Warning: ignoring unreadable cache entry {key}: {e}")
+            result = None
+
+        with self._lock:
+            if result is None:
+                self.misses += 1
+            else:
+                self.hits += 1
+        return result
+
+    def put(self, key: str, result: dict) -> bool:
+        """
+        Stores a result. A failed write (read-only or full disk, bad cache
+        directory) is reported and skipped; the caller keeps its result.
+
+        Returns:
+            bool: True if the entry was written.
+        """
+        path = self._path(key)
+        tmp_path = None
+        try:
+            os.makedirs(os.path.dirname(path), exist_ok=True)
+
+            # Write to a temp file and rename so readers never see a partial entry
+            fd, tmp_path = tempfile.mkstemp(dir=os.path.dirname(path), prefix=f"{key}.", suffix=".tmp")
+            with os.fdopen(fd, "w", encoding="utf-8") as f:
+                json.dump(result, f)
+            os.replace(tmp_path, path)
+            tmp_path = None
+            return True
+        except (OSError, TypeError, ValueError) as e:  # TypeError/ValueError: result not JSON-serializable
+            print(f"Warning: could not write cache entry {key}: {e}")
+            return False
+        finally:
+            if tmp_path:
+                try:
+                    os.remove(tmp_path)
+                except OSError:
+                    pass
+
+    def clear(self):
+        """
+        Removes every cached result, e.g. after editing the prompt.
+
+        Only files this cache wrote (entries and leftover temp files inside
+        its shard directories) are deleted, so pointing the cache at a
+        directory that holds other data never removes that data.
+        """
+        try:
+            shards = os.listdir(self.cache_dir)
+        except FileNotFoundError:
+            return
+
+        for shard in shards:
+            shard_dir = os.path.join(self.cache_dir, shard)
+            if not SHARD_PATTERN.match(shard) or not os.path.isdir(shard_dir):
+                continue
+
+            for name in os.listdir(shard_dir):
+                path = os.path.join(shard_dir, name)
+                if ENTRY_PATTERN.match(name) and os.path.isfile(path):
+                    os.remove(path)
+
+            # Only succeeds if nothing else lives in the shard directory
+            try:
+                os.rmdir(shard_dir)
+            except OSError:
+                pass
+
+    def stats(self) -> dict:
+        with self._lock:
+            total = self.hits + self.misses
+            return {
+                "hits": self.hits,
+                "misses": self.misses,
+                "hit_rate": self.hits / total if total > 0 else 0
+            }
@@ -0,0 +1,151 @@
+import os
+import sys
+import shutil
+import tempfile
+import unittest
+
+sys.path.append(os.path.abspath(os.path.join(os.path.dirname(__file__), "..")))
+from llms.result_cache import ResultCache
+from llms.base_classifier import IAMClassifier
+
+POLICY = {
+    "Version": "2012-10-17",
+    "Statement": [{"Effect": "Allow", "Action": "s3:GetObject", "Resource": "*"}]
+}
+
+class StubClassifier(IAMClassifier):
+    """Classifier that returns canned replies and counts model calls."""
+
+    def __init__(self, replies):
+        super().__init__()
+        self.model_id = "stub-model"
+        self.system_instruction = "prompt"
+        self.replies = list(replies)
+        self.calls = 0
+
+    def test_connection(self) -> bool:
+        return True
+
+    def classify_policy_uncached(self, policy_json: dict) -> dict | None:
+        self.calls += 1
+        return self.replies.pop(0)
+
+class ResultCacheTest(unittest.TestCase):
+    def setUp(self):
+        self.cache_dir = tempfile.mkdtemp()
+        self.cache = ResultCache(self.cache_dir)
+
+    def tearDown(self):
+        shutil.rmtree(self.cache_dir, ignore_errors=True)
+
+    def test_key_ignores_dict_order(self):
+        reordered = {
+            "Statement": [{"Resource": "*", "Action": "s3:GetObject", "Effect": "Allow"}],
+            "Version": "2012-10-17"
+        }
+        self.assertEqual(ResultCache.make_key("m", "p", POLICY), ResultCache.make_key("m", "p", reordered))
+
+    def test_key_changes_with_prompt_model_and_policy(self):
+        key = ResultCache.make_key("m", "p", POLICY)
+        self.assertNotEqual(key, ResultCache.make_key("m", "p2", POLICY))
+        self.assertNotEqual(key, ResultCache.make_key("m2", "p", POLICY))
+        self.assertNotEqual(key, ResultCache.make_key("m", "p", {**POLICY, "Version": "2008-10-17"}))
+
+    def test_put_get_round_trip(self):
+        key = ResultCache.make_key("m", "p", POLICY)
+        result = {"classification": "Strong", "reason": "scoped action"}
+        self.assertIsNone(self.cache.get(key))
+        self.cache.put(key, result)
+        self.assertEqual(self.cache.get(key), result)
+
+    def test_clear_removes_entries(self):
+        key = ResultCache.make_key("m", "p", POLICY)
+        self.cache.put(key, {"classification": "Weak"})
+        self.cache.clear()
+        self.assertIsNone(self.cache.get(key))
+
+    def test_clear_keeps_unrelated_files(self):
+        key = ResultCache.make_key("m", "p", POLICY)
+        self.cache.put(key, {"classification": "Weak"})
+        shard_dir = os.path.join(self.cache_dir, key[:2])
+        for path in (os.path.join(self.cache_dir, "notes.json"),
+                     os.path.join(self.cache_dir, "ab", "other.json"),
+                     os.path.join(shard_dir, "keep.txt"),
+                     os.path.join(shard_dir, "keep.tmp")):
+            os.makedirs(os.path.dirname(path), exist_ok=True)
+            with open(path, "w") as f:
+                f.write("{}")
+        with open(os.path.join(shard_dir, f"{key}.x1y2.tmp"), "w") as f:
+            f.write("{")
+
+        self.cache.clear()
+
+        self.assertIsNone(self.cache.get(key))
+        self.assertEqual(sorted(os.listdir(shard_dir)), ["keep.tmp", "keep.txt"])
+        self.assertTrue(os.path.exists(os.path.join(self.cache_dir, "notes.json")))
+        self.assertTrue(os.path.exists(os.path.join(self.cache_dir, "ab", "other.json")))
+
+    def test_failed_write_is_skipped(self):
+        blocker = os.path.join(self.cache_dir, "blocker")
+        with open(blocker, "w") as f:
+            f.write("not a directory")
+        cache = ResultCache(blocker)
+        key = ResultCache.make_key("m", "p", POLICY)
+        self.assertFalse(cache.put(key, {"classification": "Weak"}))
+        self.assertIsNone(cache.get(key))
+
+    def test_failed_serialization_leaves_no_temp_file(self):
+        key = ResultCache.make_key("m", "p", POLICY)
+        self.assertFalse(self.cache.put(key, {"classification": object()}))
+        self.assertEqual(os.listdir(os.path.join(self.cache_dir, key[:2])), [])
+
+    def test_unreadable_entry_is_a_miss(self):
+        key = ResultCache.make_key("m", "p", POLICY)
+        os.makedirs(self.cache._path(key))  # a directory where the entry file should be
+        bad_key = ResultCache.make_key("m", "p2", POLICY)
+        os.makedirs(os.path.dirname(self.cache._path(bad_key)), exist_ok=True)
+        with open(self.cache._path(bad_key), "wb") as f:
+            f.write(b"\xff\xfe")
+        self.assertIsNone(self.cache.get(key))
+        self.assertIsNone(self.cache.get(bad_key))
+        self.assertEqual(self.cache.stats()["misses"], 2)
+
+    def test_classifier_returns_result_when_cache_write_fails(self):
+        blocker = os.path.join(self.cache_dir, "blocker")
+        with open(blocker, "w") as f:
+            f.write("not a directory")
+        classifier = StubClassifier([{"classification": "Strong"}])
+        classifier.cache = ResultCache(blocker)
+        self.assertEqual(classifier.classify_policy(POLICY), {"classification": "Strong"})
+
+    def test_stats_count_hits_and_misses(self):
+        key = ResultCache.make_key("m", "p", POLICY)
+        self.cache.get(key)
+        self.cache.put(key, {"classification": "Weak"})
+        self.cache.get(key)
+        self.cache.get(key)
+        self.assertEqual(self.cache.stats(), {"hits": 2, "misses": 1, "hit_rate": 2 / 3})
+
+    def test_classifier_serves_repeat_from_cache(self):
+        classifier = StubClassifier([{"classification": "Strong", "reason": "ok"}])
+        classifier.cache = self.cache
+        first = classifier.classify_policy(POLICY)
+        self.assertEqual(classifier.classify_policy(POLICY), first)
+        self.assertEqual(classifier.calls, 1)
+        self.assertEqual(self.cache.stats()["hits"], 1)
+        self.assertEqual(self.cache.stats()["misses"], 1)
+
+    def test_classifier_does_not_cache_unusable_replies(self):
+        classifier = StubClassifier([
+            {"reason": "no classification field"},
+            {"classification": "Maybe"},
+            {"classification": "Weak"}
+        ])
+        classifier.cache = self.cache
+        classifier.classify_policy(POLICY)
+        classifier.classify_policy(POLICY)
+        self.assertEqual(classifier.classify_policy(POLICY), {"classification": "Weak"})
+        self.assertEqual(classifier.calls, 3)
+
+if __name__ == "__main__":
+    unittest.main()